@@ -23,6 +23,9 @@ enum PINASSIGN {
   MOSI = 0,
   SCK  = 1,
   CS   = 2,
+  // I2C pins
+  SDA  = 6,
+  SCL  = 4,
   // Power control
   PWR_SPI = 7,
   PWR_I2C = 8,
@@ -50,17 +53,39 @@ enum PINASSIGN {
 //! The buffer to hold the data for the current page
 #define BUFFER_SIZE (MAX_PAGE_SIZE + BYTES_PER_LINE)
 
+//! Maximum number of I2C EEPROMs on one bus (selected by pins A2..A0)
+#define MAX_I2C_TARGETS 8
+
+//! I2C control byte for an EEPROM at bus address 0 (write mode)
+#define I2C_CONTROL 0xA0
+
+/** Extra delay per I2C half bit in microseconds
+ *
+ * The pinMode()/digitalWrite() calls on every transition add a lot more
+ * than this, the bit banged bus runs at a small fraction of 100KHz.
+ */
+#define I2C_DELAY 5
+
+/** Maximum number of ACK polls while waiting for a write cycle to finish
+ *
+ * Each poll is a start, a control byte and a stop (about 40 half bits) so
+ * even at the minimum delay this is well over the 10ms worst case write
+ * cycle of common parts.
+ */
+#define I2C_POLL_LIMIT 250
+
 /** Supported commands
  *
  * Each line received by the programmer starts with a single letter command,
  * these are what we support.
  */
 typedef enum {
-  CMD_RESET = '!', //!< Reset the device, clear all settings
-  CMD_INIT  = 'i', //!< Initialise and set the target device.
-  CMD_READ  = 'r', //!< Read data from EEPROM
-  CMD_WRITE = 'w', //!< Write data to EEPROM
-  CMD_DONE  = 'd', //!< Done. Flush any pending data
+  CMD_RESET  = '!', //!< Reset the device, clear all settings
+  CMD_INIT   = 'i', //!< Initialise and set the target device.
+  CMD_READ   = 'r', //!< Read data from EEPROM
+  CMD_WRITE  = 'w', //!< Write data to EEPROM
+  CMD_DONE   = 'd', //!< Done. Flush any pending data
+  CMD_TARGET = 't', //!< Select the I2C bus addresses to use
   } COMMAND;
 
 /** Possible modes
@@ -120,6 +145,7 @@ static bool     s_spi;          //!< True for SPI interface
 static uint16_t s_pageSize;     //!< Size of a page in bytes
 static uint8_t  s_addrBytes;    //!< Number of bytes to send as an address
 static uint32_t s_chipSize;     //!< Chip capacity in bytes
+static uint8_t  s_targets;      //!< Selected I2C targets (bit n = bus address n)
 
 //---------------------------------------------------------------------------
 // Hex conversion helpers
@@ -204,26 +230,247 @@ static void spiSendAddress(uint32_t address) {
     }
   }
 
+/** Put the I2C lines in a safe state when the chip is not powered
+ *
+ * The lines are left as plain inputs with the pull ups disabled so no
+ * current is fed into the unpowered chip through its I/O pins.
+ */
+static void i2cIdle() {
+  pinMode(SDA, INPUT);
+  digitalWrite(SDA, LOW);
+  pinMode(SCL, INPUT);
+  digitalWrite(SCL, LOW);
+  }
+
+/** Release an I2C line and let the pull up take it high
+ *
+ * This enables the internal pull up so must only be used while the I2C
+ * supply is on.
+ */
+static void i2cRelease(uint8_t pin) {
+  pinMode(pin, INPUT);
+  digitalWrite(pin, HIGH);
+  delayMicroseconds(I2C_DELAY);
+  }
+
+/** Drive an I2C line low
+ */
+static void i2cPullDown(uint8_t pin) {
+  digitalWrite(pin, LOW);
+  pinMode(pin, OUTPUT);
+  delayMicroseconds(I2C_DELAY);
+  }
+
+/** Generate an I2C start (or repeated start) condition
+ */
+static void i2cStart() {
+  i2cRelease(SDA);
+  i2cRelease(SCL);
+  i2cPullDown(SDA);
+  i2cPullDown(SCL);
+  }
+
+/** Generate an I2C stop condition
+ */
+static void i2cStop() {
+  i2cPullDown(SDA);
+  i2cRelease(SCL);
+  i2cRelease(SDA);
+  }
+
+/** Send a single byte over I2C
+ *
+ * @param value the byte to send
+ *
+ * @return true if the byte was acknowledged by the slave.
+ */
+static bool i2cWriteByte(uint8_t value) {
+  for(uint8_t mask=0x80; mask; mask>>=1) {
+    if(value & mask)
+      i2cRelease(SDA);
+    else
+      i2cPullDown(SDA);
+    i2cRelease(SCL);
+    i2cPullDown(SCL);
+    }
+  // Read the acknowledgement
+  i2cRelease(SDA);
+  i2cRelease(SCL);
+  bool ack = (digitalRead(SDA)==LOW);
+  i2cPullDown(SCL);
+  return ack;
+  }
+
+/** Read a single byte over I2C
+ *
+ * @param ack true to acknowledge the byte (more bytes will be read)
+ *
+ * @return the byte received.
+ */
+static uint8_t i2cReadByte(bool ack) {
+  uint8_t value = 0;
+  i2cRelease(SDA);
+  for(uint8_t count=0; count<8; count++) {
+    i2cRelease(SCL);
+    value = (value << 1) | ((digitalRead(SDA)==HIGH)?1:0);
+    i2cPullDown(SCL);
+    }
+  // Send the acknowledgement
+  if(ack)
+    i2cPullDown(SDA);
+  i2cRelease(SCL);
+  i2cPullDown(SCL);
+  i2cRelease(SDA);
+  return value;
+  }
+
+/** Wait for an I2C EEPROM to finish any write cycle in progress
+ *
+ * The chip will not acknowledge its address until the internal write cycle
+ * has completed so we poll until it does.
+ *
+ * @param target the bus address of the chip (0 to 7)
+ *
+ * @return true if the chip is ready, false if it did not respond.
+ */
+static bool i2cWaitReady(uint8_t target) {
+  for(uint16_t count=0; count<I2C_POLL_LIMIT; count++) {
+    i2cStart();
+    bool ack = i2cWriteByte(I2C_CONTROL | (target << 1));
+    i2cStop();
+    if(ack)
+      return true;
+    }
+  return false;
+  }
+
+/** Address a location in an I2C EEPROM
+ *
+ * Sends a start condition, the control byte and the address. The bus is
+ * left ready to send data bytes or a repeated start.
+ *
+ * @param target the bus address of the chip (0 to 7)
+ * @param addr the address in the EEPROM
+ *
+ * @return true if the chip acknowledged, false otherwise (the bus will have
+ *         been released).
+ */
+static bool i2cSelect(uint8_t target, uint32_t addr) {
+  i2cStart();
+  if(!i2cWriteByte(I2C_CONTROL | (target << 1))) {
+    i2cStop();
+    return false;
+    }
+  for(uint8_t count=s_addrBytes; count; count--) {
+    if(!i2cWriteByte((uint8_t)(addr >> ((count - 1) * 8)))) {
+      i2cStop();
+      return false;
+      }
+    }
+  return true;
+  }
+
 /** Read data from an I2C EEPROM
+ *
+ * Data is read from the lowest selected bus address.
  *
  * @param addr the address in the EEPROM to read from
  * @param length the number of bytes to read
  * @param pBuffer pointer to the buffer to contain the data
+ *
+ * @return true on success, false if the chip did not respond.
  */
-void i2cReadData(uint32_t addr, uint16_t length, uint8_t *pBuffer) {
-  // TODO: Implement this
+bool i2cReadData(uint32_t addr, uint16_t length, uint8_t *pBuffer) {
+  if(!length)
+    return true;
+  uint8_t target = 0;
+  while((target<(MAX_I2C_TARGETS - 1))&&!(s_targets & (1 << target)))
+    target++;
+  // Wait for any outstanding write then send the address
+  if(!i2cWaitReady(target)||!i2cSelect(target, addr))
+    return false;
+  // Switch to read mode and clock out the data
+  i2cStart();
+  if(!i2cWriteByte(I2C_CONTROL | (target << 1) | 0x01)) {
+    i2cStop();
+    return false;
+    }
+  for(uint16_t index=0; index<length; index++)
+    pBuffer[index] = i2cReadByte(index<(length - 1));
+  i2cStop();
+  return true;
   }
 
-/** Write a single page to an I2C EEPROM
+/** Verify a single page in an I2C EEPROM
+ *
+ * @param target the bus address of the chip (0 to 7)
+ * @param addr the address of the page in the EEPROM
+ * @param pBuffer pointer to the buffer containing the expected data
+ * @param pMatch set to true if the page contents match the buffer.
+ *
+ * @return true if the chip responded, false otherwise.
+ */
+static bool i2cVerifyPage(uint8_t target, uint32_t addr, uint8_t *pBuffer, bool *pMatch) {
+  if(!i2cWaitReady(target)||!i2cSelect(target, addr))
+    return false;
+  i2cStart();
+  if(!i2cWriteByte(I2C_CONTROL | (target << 1) | 0x01)) {
+    i2cStop();
+    return false;
+    }
+  *pMatch = true;
+  for(uint16_t index=0; index<s_pageSize; index++) {
+    if(i2cReadByte(index<(s_pageSize - 1))!=pBuffer[index])
+      *pMatch = false;
+    }
+  i2cStop();
+  return true;
+  }
+
+/** Write a single page to all selected I2C EEPROMs
  *
  * Writes must start at a page boundary, this function assumes the caller has
  * arranged that.
  *
+ * The page is loaded into each selected chip in turn so that one chip is
+ * being loaded while the others are in their internal write cycle. Each chip
+ * is then polled (in the same order) until the cycle has completed and the
+ * page is read back to verify it.
+ *
  * @param addr the address in the EEPROM to write to.
  * @param pBuffer pointer to the buffer containing the data
+ * @param pMissing set to a mask of the targets that did not respond.
+ *
+ * @return a mask of the targets that did not verify.
  */
-void i2cWritePage(uint32_t addr, uint8_t *pBuffer) {
-  // TODO: Implement this
+uint8_t i2cWritePage(uint32_t addr, uint8_t *pBuffer, uint8_t *pMissing) {
+  uint8_t failed = 0;
+  uint8_t target, mask;
+  *pMissing = 0;
+  // Load the page into each chip
+  for(target=0, mask=0x01; target<MAX_I2C_TARGETS; target++, mask<<=1) {
+    if(!(s_targets & mask))
+      continue;
+    if(!i2cWaitReady(target)||!i2cSelect(target, addr)) {
+      *pMissing |= mask;
+      continue;
+      }
+    for(uint16_t index=0; index<s_pageSize; index++)
+      i2cWriteByte(pBuffer[index]);
+    // The stop condition starts the internal write cycle
+    i2cStop();
+    }
+  // Now verify each chip as it completes
+  for(target=0, mask=0x01; target<MAX_I2C_TARGETS; target++, mask<<=1) {
+    if(!(s_targets & mask)||(*pMissing & mask))
+      continue;
+    bool match = false;
+    if(!i2cVerifyPage(target, addr, pBuffer, &match))
+      *pMissing |= mask;
+    else if(!match)
+      failed |= mask;
+    }
+  return failed;
   }
 
 /** Read data from an SPI EEPROM
@@ -298,6 +545,30 @@ static uint32_t getAddress(uint8_t *pAddr) {
   return result;
   }
 
+/** Write the page at the start of the buffer to the chip
+ *
+ * On failure an error response is sent to the client.
+ *
+ * @return true on success, false on failure.
+ */
+static bool writePage() {
+  if(s_spi) {
+    spiWritePage(s_buffBase, s_buffer);
+    return true;
+    }
+  uint8_t missing;
+  uint8_t failed = i2cWritePage(s_buffBase, s_buffer, &missing);
+  if(missing) {
+    uartFormatP(PSTR("-No response from targets %x.\n"), missing);
+    return false;
+    }
+  if(failed) {
+    uartFormatP(PSTR("-Verify failed on targets %x.\n"), failed);
+    return false;
+    }
+  return true;
+  }
+
 /** Send a response to the client
  *
  * @param success if true the previous command succeeded.
@@ -310,6 +581,34 @@ void respond(bool success, const char *cszMessage) {
   uartWrite(EOL);
   }
 
+/** Determine if more than one I2C target is selected
+ */
+static bool multipleTargets() {
+  return !s_spi && (s_targets & (s_targets - 1));
+  }
+
+/** Read data from the chip
+ *
+ * On failure an error response is sent to the client.
+ *
+ * @param addr the address in the EEPROM to read from
+ * @param length the number of bytes to read
+ * @param pBuffer pointer to the buffer to contain the data
+ *
+ * @return true on success, false on failure.
+ */
+static bool readData(uint32_t addr, uint16_t length, uint8_t *pBuffer) {
+  if(s_spi) {
+    spiReadData(addr, length, pBuffer);
+    return true;
+    }
+  if(!i2cReadData(addr, length, pBuffer)) {
+    respond(false, PSTR("No response from EEPROM."));
+    return false;
+    }
+  return true;
+  }
+
 /** Perform the 'init' command
  *
  * @param data the number of data bytes provided on the line.
@@ -335,6 +634,8 @@ static bool doInit(uint8_t data) {
   // Get the number of bytes to use in the address
   value = (ident & EEPROM_ADDR_BYTES_MASK) >> EEPROM_ADDR_BYTES_SHIFT;
   s_addrBytes = value;
+  // Default to a single I2C chip at bus address 0
+  s_targets = 0x01;
   // Make sure the reserved values are 0
   value = (ident & EEPROM_RESERVED_MASK) >> EEPROM_RESERVED_SHIFT;
   if(value) {
@@ -366,10 +667,8 @@ static bool doRead(uint8_t data) {
     }
   // Read the data into the buffer
   uint16_t length = ((s_chipSize - addr)<BYTES_PER_LINE)?s_chipSize - addr:BYTES_PER_LINE;
-  if(s_spi)
-    spiReadData(addr, length, &s_szLine[4]);
-  else
-    i2cReadData(addr, length, &s_szLine[4]);
+  if(!readData(addr, length, &s_szLine[4]))
+    return false;
   // Calculate the checksum
   uint16_t check = checksum(&s_szLine[1], length + 3);
   s_szLine[length + 4] = (uint8_t)(check >> 8);
@@ -415,12 +714,15 @@ static bool doWrite(uint8_t data, bool first) {
     s_buffBase = addr & ~((uint32_t)s_pageSize - 1);
     s_buffIndex = (uint8_t)(addr - s_buffBase);
     // If we are starting part way through a page we prime with the
-    // existing data on the chip
+    // existing data on the chip. With several targets that data would come
+    // from one chip only so writes must be page aligned.
     if(s_buffIndex) {
-      if(s_spi)
-        spiReadData(s_buffBase, s_buffIndex, s_buffer);
-      else
-        i2cReadData(s_buffBase, s_buffIndex, s_buffer);
+      if(multipleTargets()) {
+        respond(false, PSTR("Multiple targets need page aligned writes."));
+        return false;
+        }
+      if(!readData(s_buffBase, s_buffIndex, s_buffer))
+        return false;
       }
     }
   // Data must be sequential
@@ -435,10 +737,8 @@ static bool doWrite(uint8_t data, bool first) {
   // Write any full pages to the chip
   while(s_buffIndex>=s_pageSize) {
     // Write the page
-    if(s_spi)
-      spiWritePage(s_buffBase, s_buffer);
-    else
-      i2cWritePage(s_buffBase, s_buffer);
+    if(!writePage())
+      return false;
     // Adust the buffer
     for(offset=s_pageSize;offset<s_buffIndex;offset++)
       s_buffer[offset - s_pageSize] = s_buffer[offset];
@@ -463,20 +763,47 @@ static bool doDone(uint8_t data) {
   // Do we have anything left to write?
   if(s_buffIndex>0) {
     // Grab the data already in the page to fill it out then write
-    if(s_spi) {
-      spiReadData(s_buffBase + s_buffIndex, s_pageSize - s_buffIndex, &s_buffer[s_buffIndex]);
-      spiWritePage(s_buffBase, s_buffer);
-      }
-    else {
-      i2cReadData(s_buffBase + s_buffIndex, s_pageSize - s_buffIndex, &s_buffer[s_buffIndex]);
-      i2cWritePage(s_buffBase, s_buffer);
+    if(multipleTargets()) {
+      respond(false, PSTR("Multiple targets need page aligned writes."));
+      return false;
       }
+    if(!readData(s_buffBase + s_buffIndex, s_pageSize - s_buffIndex, &s_buffer[s_buffIndex]))
+      return false;
+    if(!writePage())
+      return false;
     }
   // All done
   respond(true, NULL);
   return true;
   }
 
+/** Perform the 'target' command
+ *
+ * Selects the I2C bus addresses to program. Writes go to every selected chip,
+ * reads come from the lowest selected address.
+ *
+ * @param data the number of data bytes provided on the line.
+ *
+ * @return true on success, false on failure.
+ */
+static bool doTarget(uint8_t data) {
+  if(data!=1) {
+    respond(false, PSTR("Target mask required."));
+    return false;
+    }
+  if(s_spi) {
+    respond(false, PSTR("Targets only apply to I2C."));
+    return false;
+    }
+  if(!s_szLine[1]) {
+    respond(false, PSTR("No targets selected."));
+    return false;
+    }
+  s_targets = s_szLine[1];
+  uartFormatP(PSTR("+Targets %x.\n"), s_targets);
+  return true;
+  }
+
 //---------------------------------------------------------------------------
 // Main program (setup and loop)
 //---------------------------------------------------------------------------
@@ -490,6 +817,7 @@ void setup() {
   digitalWrite(SCK, LOW);
   pinMode(CS, OUTPUT);
   digitalWrite(CS, HIGH);
+  i2cIdle();
   pinMode(PWR_SPI, OUTPUT);
   digitalWrite(PWR_SPI, LOW);
   pinMode(PWR_I2C, OUTPUT);
@@ -514,6 +842,7 @@ void loop() {
     s_mode = MODE_WAITING;
     digitalWrite(PWR_SPI, LOW);
     digitalWrite(PWR_I2C, LOW);
+    i2cIdle();
     uartPrintP(BANNER);
     }
   else {
@@ -523,6 +852,11 @@ void loop() {
         if(doInit(data)) {
           // Power on the selected device
           digitalWrite(s_spi?PWR_SPI:PWR_I2C, HIGH);
+          // Only enable the I2C pull ups once the chip is powered
+          if(!s_spi) {
+            i2cRelease(SDA);
+            i2cRelease(SCL);
+            }
           s_mode = MODE_READY;
           }
         }
@@ -536,6 +870,8 @@ void loop() {
         if(doWrite(data, true))
           s_mode = MODE_WRITING;
         }
+      else if(s_szLine[0]==CMD_TARGET)
+        doTarget(data);
       else
         respond(false, PSTR("Command invalid for mode."));
       }
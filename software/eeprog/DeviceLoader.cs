@@ -4,6 +4,7 @@ using System.IO.Ports;
 using System.Text;
 using System.Threading;
 using System.Threading.Tasks;
+using System.Diagnostics;
 using System.Collections.Generic;
 
 namespace eeprog
@@ -13,10 +14,12 @@ namespace eeprog
   /// </summary>
   public enum ProgressState
   {
-    Read,   // Read a page
-    Write,  // Wrote a page
-    Verify, // Verified a page
-    Error,  // Intermediate (non-fatal) error
+    Read,      // Read a page
+    Write,     // Wrote a page
+    Verify,    // Verified a page
+    Error,     // Intermediate (non-fatal) error
+    Complete,  // Operation completed
+    Cancelled, // Operation was cancelled
   }
 
   /// <summary>
@@ -43,9 +46,12 @@ namespace eeprog
   /// </summary>
   public enum Operation
   {
-    Idle,    // No operation is being performed
-    Reading, // Reading flash contents
-    Writing, // Writing flash contents
+    Idle,        // No operation is being performed
+    Reading,     // Reading flash contents
+    Writing,     // Writing flash contents
+    Running,     // Running a job
+    Configuring, // Configuring the chip for a session
+    Verifying,   // Comparing flash contents
   }
 
   public class Response
@@ -81,6 +87,19 @@ namespace eeprog
     }
   }
 
+  /// <summary>
+  /// Exceptions for corrupted data received from the programmer. Unlike other
+  /// protocol errors these are worth retrying.
+  /// </summary>
+  public class ChecksumException : ProtocolException
+  {
+    public ChecksumException(string message)
+      : base(message)
+    {
+      // Do nothing
+    }
+  }
+
   /// <summary>
   /// This class wraps all interaction with the remote machine in a background
   /// thread.
@@ -180,12 +199,25 @@ namespace eeprog
       get;
       private set;
     }
+
+    /// <summary>
+    /// Timing and throughput statistics for the current (or last) operation.
+    /// </summary>
+    public Telemetry Telemetry
+    {
+      get;
+      private set;
+    }
     #endregion
 
     #region "Instance Variables"
     private bool           m_cancel;     // Cancel of the current operation
     private AutoResetEvent m_event;      // Event to control command queue
     private SerialPort     m_serial;     // The serial port for communication
+    private string         m_port;       // Port name for the open session
+    private EEPROM         m_eeprom;     // Chip configured for the session
+    private byte           m_targets;    // I2C targets selected for the session
+    private bool           m_reset;      // Programmer must be reset before 'i'
     #endregion
 
     #region "Event Dispatch"
@@ -212,6 +244,7 @@ namespace eeprog
 
     private void FireConnectionStateChanged(ConnectionState state)
     {
+      ConnectionState = state;
       ConnectionStateChangedHandler handler = ConnectionStateChanged;
       if (handler != null)
         handler(this, state);
@@ -306,13 +339,13 @@ namespace eeprog
     private void VerifyChecksum(byte[] data)
     {
       if ((data == null) || (data.Length < 2))
-        throw new ProtocolException("Insufficient data received.");
+        throw new ChecksumException("Insufficient data received.");
       UInt16 checksum = 0;
       for (int i = 0; i < (data.Length - 2); i++)
         checksum += (UInt16)data[i];
       UInt16 received = (UInt16)((data[data.Length - 2] << 8) | data[data.Length - 1]);
       if (checksum != received)
-        throw new ProtocolException(String.Format("Invalid checksum - calculated {0:X4}, expected {1:X4}", checksum, received));
+        throw new ChecksumException(String.Format("Invalid checksum - calculated {0:X4}, expected {1:X4}", checksum, received));
     }
 
     /// <summary>
@@ -344,15 +377,36 @@ namespace eeprog
     private string SendCommand(string cmd)
     {
       ASCIIEncoding encoding = new ASCIIEncoding();
+      CommandTiming timing = new CommandTiming();
+      timing.Command = cmd[0];
+      Stopwatch timer = Stopwatch.StartNew();
       // Send the command
       byte[] data = encoding.GetBytes(cmd + "\n");
       m_serial.Write(data, 0, data.Length);
+      timing.Send = timer.Elapsed;
+      timing.BytesSent = data.Length;
       FireCommunications(Direction.Output, cmd);
       // Wait for the response
       List<byte> result = new List<byte>();
-      for (int ch = m_serial.ReadByte(); (ch != '\n') && (result.Count < 128); ch = m_serial.ReadByte())
-        result.Add((byte)ch);
+      int ch;
+      try
+      {
+        ch = m_serial.ReadByte();
+        timing.FirstByte = timer.Elapsed;
+        for (; (ch != '\n') && (result.Count < 128); ch = m_serial.ReadByte())
+          result.Add((byte)ch);
+      }
+      catch (TimeoutException)
+      {
+        Telemetry.RecordTimeout(timing.Command);
+        throw;
+      }
+      timing.Line = timer.Elapsed;
+      timing.BytesReceived = result.Count + ((ch == '\n') ? 1 : 0);
+      Telemetry.Record(timing);
       string response = encoding.GetString(result.ToArray(), 0, result.Count).TrimEnd();
+      if ((response.Length > 0) && (response[0] == OPERATION_FAILED))
+        Telemetry.RecordFailure(timing.Command);
       FireCommunications(Direction.Input, response);
       return response;
     }
@@ -361,128 +415,543 @@ namespace eeprog
     {
       return SendCommand(String.Format("{0}{1:x4}", cmd, ident));
     }
-    #endregion
 
-    #region "Public Methods"
-    public DeviceLoader()
+    /// <summary>
+    /// Select the I2C bus addresses to use. Has no effect for SPI devices.
+    /// </summary>
+    /// <param name="eeprom"></param>
+    /// <param name="targets">Bit mask of bus addresses (bit n = address n)</param>
+    private void SelectTargets(EEPROM eeprom, byte targets)
     {
-      m_event = new AutoResetEvent(false);
-      ConnectionState = ConnectionState.Disconnected;
+      if (eeprom.Connection != ConnectionType.I2C)
+        return;
+      if (targets == 0)
+        throw new ArgumentException("At least one target must be selected.");
+      CheckResponse(SendCommand(String.Format("t{0:x2}", targets)));
+    }
+
+    /// <summary>
+    /// Abandon the current operation if a cancel has been requested.
+    /// </summary>
+    private void CheckCancel()
+    {
+      if (m_cancel)
+        throw new OperationCanceledException("Operation cancelled.");
+    }
+
+    private void RequireSession()
+    {
+      if (m_serial == null)
+        throw new InvalidOperationException("No session open.");
     }
 
-    public void Read(string port, EEPROM eeprom, UInt32 offset, UInt32 size, FileInfo target)
+    private void RequireConfigured()
+    {
+      RequireSession();
+      if (m_eeprom == null)
+        throw new InvalidOperationException("No EEPROM configured.");
+    }
+
+    /// <summary>
+    /// Set the EEPROM type and I2C targets, only sending the commands needed
+    /// to change the current configuration.
+    /// </summary>
+    /// <param name="eeprom"></param>
+    /// <param name="targets">I2C bus addresses to use (bit n = address n)</param>
+    private void ConfigureChip(EEPROM eeprom, byte targets)
+    {
+      RequireSession();
+      if ((m_eeprom == null) || (m_eeprom.ID != eeprom.ID))
+      {
+        // The programmer only accepts a new identifier after a reset
+        if (m_reset)
+        {
+          FlushInput();
+          CheckSignature(SendCommand("!"));
+        }
+        m_eeprom = null;
+        m_reset = true;
+        CheckResponse(SendCommand('i', eeprom.ID));
+        m_eeprom = eeprom;
+        m_targets = 0x01;
+      }
+      if (targets != m_targets)
+      {
+        SelectTargets(eeprom, targets);
+        m_targets = targets;
+      }
+    }
+
+    /// <summary>
+    /// Determine if a write can be sent with the given targets. Partial pages
+    /// can't be merged when writing to several I2C chips so both ends of the
+    /// region must be on a page boundary.
+    /// </summary>
+    /// <param name="eeprom"></param>
+    /// <param name="targets"></param>
+    /// <param name="address"></param>
+    /// <param name="count"></param>
+    /// <returns></returns>
+    private static bool CanWrite(EEPROM eeprom, byte targets, UInt64 address, UInt64 count)
+    {
+      if ((eeprom.Connection != ConnectionType.I2C) || ((targets & (targets - 1)) == 0))
+        return true;
+      return ((address % eeprom.PageSize) == 0) && (((address + count) % eeprom.PageSize) == 0);
+    }
+
+    /// <summary>
+    /// Run a public session method. The session must be open and idle, the
+    /// chip configuration is discarded on failure so the next call resets the
+    /// programmer. Exceptions are passed on to the caller.
+    /// </summary>
+    /// <typeparam name="T"></typeparam>
+    /// <param name="operation"></param>
+    /// <param name="action"></param>
+    /// <returns></returns>
+    private T SessionCall<T>(Operation operation, Func<T> action)
     {
       if (Operation != Operation.Idle)
         throw new InvalidOperationException("Operation already in progress.");
-      Operation = Operation.Reading;
+      RequireSession();
+      Operation = operation;
+      m_cancel = false;
+      Telemetry.Start();
       try
       {
-        // Establish a connection
-        FireConnectionStateChanged(ConnectionState.Connecting);
-        OpenPort(port);
-        FlushInput();
-        CheckSignature(SendCommand("!"));
-        FireConnectionStateChanged(ConnectionState.Connected);
-        // Set the EEPROM identifier
-        CheckResponse(SendCommand('i', eeprom.ID));
-        // Read the data
-        byte[] data = new byte[size];
-        UInt32 received = 0;
-        FireProgress(ProgressState.Read, 0, (int)size + 1, "Reading data.");
-        while (received < size)
+        return action();
+      }
+      catch
+      {
+        m_eeprom = null;
+        throw;
+      }
+      finally
+      {
+        Telemetry.Stop();
+        Operation = Operation.Idle;
+      }
+    }
+
+    private void SessionCall(Operation operation, Action action)
+    {
+      SessionCall<object>(operation, () =>
+      {
+        action();
+        return null;
+      });
+    }
+
+    /// <summary>
+    /// Read a block of data from the EEPROM. Individual lines are retried on
+    /// error.
+    /// </summary>
+    /// <param name="offset"></param>
+    /// <param name="size"></param>
+    /// <param name="state">State to report in progress events</param>
+    /// <param name="message">Initial progress message</param>
+    /// <returns></returns>
+    private byte[] ReadBlock(UInt32 offset, UInt32 size, ProgressState state, string message)
+    {
+      byte[] data = new byte[size];
+      UInt32 received = 0;
+      FireProgress(state, 0, (int)size + 1, message);
+      while (received < size)
+      {
+        CheckCancel();
+        // Ask for the next block (reads are safe to repeat if the data was
+        // corrupted or lost, failure responses are reported immediately)
+        string command = String.Format("r{0:x6}", offset);
+        Response response = null;
+        for (int retry = 0; response == null; retry++)
         {
-          // Ask for the next block
-          Response response = CheckResponse(SendCommand(String.Format("r{0:x6}", offset)));
-          VerifyChecksum(response.Data);
-          // Add it to the array
-          for (int i = 3; (i < (response.Data.Length - 2)) && (received < size); i++, offset++)
-            data[received++] = response.Data[i];
-          // Update progress
-          FireProgress(ProgressState.Read, (int)offset, (int)size + 1);
+          try
+          {
+            response = CheckResponse(SendCommand(command));
+            VerifyChecksum(response.Data);
+          }
+          catch (Exception ex)
+          {
+            if ((retry >= MAX_RETRIES) || !((ex is ChecksumException) || (ex is TimeoutException)))
+              throw;
+            response = null;
+            Telemetry.RecordRetry(command[0]);
+            FireProgress(ProgressState.Error, (int)received, (int)size + 1, String.Format("Retrying read at {0:x6} - {1}", offset, ex.Message));
+            FlushInput();
+          }
         }
-        // Now save the data to the file
-        FireProgress(ProgressState.Read, (int)offset, (int)size + 1, String.Format("Saving to '{0}'", target.FullName));
-        File.WriteAllBytes(target.FullName, data);
+        // The programmer returns no data at the end of the chip
+        if (response.Data.Length <= 5)
+          throw new ProtocolException(String.Format("No data received at {0:x6}", offset));
+        // Add it to the array
+        for (int i = 3; (i < (response.Data.Length - 2)) && (received < size); i++, offset++)
+          data[received++] = response.Data[i];
+        // Update progress
+        FireProgress(state, (int)received, (int)size + 1);
       }
-      catch (ProtocolException ex)
+      return data;
+    }
+
+    /// <summary>
+    /// Write a block of data to the EEPROM and flush it.
+    /// </summary>
+    /// <param name="data"></param>
+    /// <param name="index">Index of the first byte in data to write</param>
+    /// <param name="count">Number of bytes to write</param>
+    /// <param name="address">Address in the EEPROM to write to</param>
+    /// <param name="message">Initial progress message</param>
+    private void WriteBlock(byte[] data, int index, int count, UInt32 address, string message)
+    {
+      if (!CanWrite(m_eeprom, m_targets, address, (UInt64)count))
+        throw new ProtocolException("Writes to multiple targets must start and end on a page boundary.");
+      FireProgress(ProgressState.Write, 0, count + 1, message);
+      for (int written = 0; written < count; )
       {
-        FireError(ex.Message);
+        CheckCancel();
+        // Write the next block
+        int chunk = Math.Min(32, count - written);
+        CheckResponse(SendCommand("w" + HexString(data, address + (UInt32)written, index + written, chunk)));
+        written += chunk;
+        // Update progress
+        FireProgress(ProgressState.Write, written, count + 1);
       }
-      catch (Exception ex)
+      // Finish the operation
+      CheckResponse(SendCommand("d"));
+    }
+
+    /// <summary>
+    /// Compare a block of the EEPROM with the given data. A ProtocolException
+    /// is raised on the first mismatch.
+    /// </summary>
+    /// <param name="data"></param>
+    /// <param name="address"></param>
+    /// <param name="message">Initial progress message</param>
+    private void VerifyBlock(byte[] data, UInt32 address, string message)
+    {
+      byte[] actual = ReadBlock(address, (UInt32)data.Length, ProgressState.Verify, message);
+      for (int i = 0; i < data.Length; i++)
       {
-        FireError("Unexpected error during operation.", ex);
+        if (actual[i] != data[i])
+          throw new ProtocolException(String.Format("Verify failed at {0:x6} - read {1:x2}, expected {2:x2}", address + i, actual[i], data[i]));
       }
-      finally
+    }
+
+    /// <summary>
+    /// Make sure every step in a job can be run before anything is sent. Each
+    /// region must fit in the EEPROM it will be used with, targets are only
+    /// allowed for I2C parts and writes to several targets must be page
+    /// aligned. A JobException is raised for the first step that fails.
+    /// </summary>
+    /// <param name="eeprom">The EEPROM type to use until the job selects one</param>
+    /// <param name="job"></param>
+    private void CheckJob(EEPROM eeprom, Job job)
+    {
+      byte targets = 0x01;
+      foreach (JobStep step in job.Steps)
       {
-        try
+        UInt64 size;
+        switch (step.Action)
         {
-          if (m_serial != null)
-            m_serial.Close();
-          m_serial = null;
-        }
-        catch {
-          // Just ignore it
+          case JobAction.Device:
+            eeprom = step.EEPROM;
+            targets = 0x01;
+            continue;
+          case JobAction.Targets:
+            if (eeprom.Connection != ConnectionType.I2C)
+              throw new JobException(String.Format("Line {0}: targets only apply to I2C EEPROMs.", step.Line));
+            targets = step.Targets;
+            continue;
+          case JobAction.Read:
+            size = step.Size;
+            break;
+          case JobAction.Write:
+          case JobAction.Verify:
+            if (!step.File.Exists)
+              throw new JobException(String.Format("Line {0}: file '{1}' not found.", step.Line, step.File.FullName));
+            size = (UInt64)step.File.Length;
+            break;
+          default:
+            continue;
         }
-        FireConnectionStateChanged(ConnectionState.Disconnected);
-        Operation = Operation.Idle;
+        if ((UInt64)step.Address + size > eeprom.Size)
+          throw new JobException(String.Format("Line {0}: region {1:x6} - {2:x6} is outside the {3} EEPROM.", step.Line, step.Address, (UInt64)step.Address + size, eeprom.SizeInK));
+        if ((step.Action == JobAction.Write) && (size > 0) && !CanWrite(eeprom, targets, step.Address, size))
+          throw new JobException(String.Format("Line {0}: writes to multiple targets must start and end on a {1} byte page boundary.", step.Line, eeprom.PageSize));
       }
     }
 
-    public void Write(string port, EEPROM eeprom, UInt32 offset, FileInfo source)
+    /// <summary>
+    /// Run an operation, opening a session for it if one is not already open.
+    /// Errors are reported through the Error event.
+    /// </summary>
+    /// <param name="operation"></param>
+    /// <param name="port"></param>
+    /// <param name="action"></param>
+    /// <param name="validate">Optional checks to make before connecting</param>
+    private void RunOperation(Operation operation, string port, Action action, Action validate = null)
     {
       if (Operation != Operation.Idle)
         throw new InvalidOperationException("Operation already in progress.");
-      Operation = Operation.Writing;
+      Operation = operation;
+      m_cancel = false;
+      Telemetry.Start();
+      bool owned = (m_serial == null);
       try
       {
-        // Read the data from the file
-        byte[] data = File.ReadAllBytes(source.FullName);
+        if (validate != null)
+          validate();
         // Establish a connection
-        FireConnectionStateChanged(ConnectionState.Connecting);
-        OpenPort(port);
-        FlushInput();
-        CheckSignature(SendCommand("!"));
-        FireConnectionStateChanged(ConnectionState.Connected);
-        // Set the EEPROM identifier
-        CheckResponse(SendCommand('i', eeprom.ID));
-        // Write the data
-        FireProgress(ProgressState.Write, 0, data.Length + 1, "Writing data.");
-        while (offset < data.Length)
-        {
-          // Write the next block
-          int chunk = Math.Min(32, data.Length - (int)offset);
-          Response response = CheckResponse(SendCommand("w" + HexString(data, offset, (int)offset, chunk)));
-          offset += (UInt32)chunk;
-          // Update progress
-          FireProgress(ProgressState.Write, (int)offset, data.Length + 1);
-        }
-        // Finish the operation
-        CheckResponse(SendCommand("d"));
+        if (owned)
+          Open(port);
+        else if (port != m_port)
+          throw new InvalidOperationException(String.Format("Session is open on '{0}'.", m_port));
+        action();
+      }
+      catch (OperationCanceledException ex)
+      {
+        FireProgress(ProgressState.Cancelled, 0, 1, ex.Message);
+        m_eeprom = null;
       }
       catch (ProtocolException ex)
+      {
+        FireError(ex.Message);
+        m_eeprom = null;
+      }
+      catch (JobException ex)
       {
         FireError(ex.Message);
       }
       catch (Exception ex)
       {
         FireError("Unexpected error during operation.", ex);
+        m_eeprom = null;
       }
       finally
       {
-        try
-        {
-          if (m_serial != null)
-            m_serial.Close();
-          m_serial = null;
-        }
-        catch
-        {
-          // Just ignore it
-        }
-        FireConnectionStateChanged(ConnectionState.Disconnected);
+        // Stop timing first, the disconnect event reads the statistics
+        Telemetry.Stop();
+        if (owned)
+          Close();
         Operation = Operation.Idle;
       }
     }
+    #endregion
+
+    #region "Public Methods"
+    public DeviceLoader()
+    {
+      m_event = new AutoResetEvent(false);
+      Telemetry = new Telemetry();
+      ConnectionState = ConnectionState.Disconnected;
+    }
+
+    /// <summary>
+    /// Open a session with the programmer. The connection (and any chip
+    /// configuration) is kept until Close() is called so several operations
+    /// can be performed without repeating the start up sequence. Exceptions
+    /// are passed on to the caller.
+    /// </summary>
+    /// <param name="port"></param>
+    public void Open(string port)
+    {
+      if (m_serial != null)
+        throw new InvalidOperationException("Session already open.");
+      FireConnectionStateChanged(ConnectionState.Connecting);
+      try
+      {
+        OpenPort(port);
+        FlushInput();
+        CheckSignature(SendCommand("!"));
+      }
+      catch
+      {
+        Close();
+        throw;
+      }
+      m_port = port;
+      m_eeprom = null;
+      m_reset = false;
+      FireConnectionStateChanged(ConnectionState.Connected);
+    }
+
+    /// <summary>
+    /// Close the current session (if any).
+    /// </summary>
+    public void Close()
+    {
+      try
+      {
+        if (m_serial != null)
+          m_serial.Close();
+      }
+      catch
+      {
+        // Just ignore it
+      }
+      m_serial = null;
+      m_port = null;
+      m_eeprom = null;
+      if (ConnectionState != ConnectionState.Disconnected)
+        FireConnectionStateChanged(ConnectionState.Disconnected);
+    }
+
+    /// <summary>
+    /// Set the EEPROM type and I2C targets for the session. The programmer is
+    /// only reinitialised if the configuration has changed. Exceptions are
+    /// passed on to the caller.
+    /// </summary>
+    /// <param name="eeprom"></param>
+    /// <param name="targets">I2C bus addresses to use (bit n = address n)</param>
+    public void Configure(EEPROM eeprom, byte targets = 0x01)
+    {
+      SessionCall(Operation.Configuring, () => ConfigureChip(eeprom, targets));
+    }
+
+    /// <summary>
+    /// Read a region of the configured EEPROM. Exceptions are passed on to the
+    /// caller.
+    /// </summary>
+    /// <param name="offset"></param>
+    /// <param name="size"></param>
+    /// <returns></returns>
+    public byte[] ReadData(UInt32 offset, UInt32 size)
+    {
+      return SessionCall(Operation.Reading, () =>
+      {
+        RequireConfigured();
+        return ReadBlock(offset, size, ProgressState.Read, "Reading data.");
+      });
+    }
+
+    /// <summary>
+    /// Write data to the configured EEPROM. Exceptions are passed on to the
+    /// caller.
+    /// </summary>
+    /// <param name="data"></param>
+    /// <param name="address"></param>
+    public void WriteData(byte[] data, UInt32 address)
+    {
+      SessionCall(Operation.Writing, () =>
+      {
+        RequireConfigured();
+        if (data.Length > 0)
+          WriteBlock(data, 0, data.Length, address, "Writing data.");
+      });
+    }
+
+    /// <summary>
+    /// Compare a region of the configured EEPROM with the given data. A
+    /// ProtocolException is raised on the first mismatch.
+    /// </summary>
+    /// <param name="data"></param>
+    /// <param name="address"></param>
+    public void VerifyData(byte[] data, UInt32 address)
+    {
+      SessionCall(Operation.Verifying, () =>
+      {
+        RequireConfigured();
+        VerifyBlock(data, address, "Verifying data.");
+      });
+    }
+
+    /// <summary>
+    /// Read the contents of an EEPROM to a file. If a session is open on the
+    /// port it is used (and left open), otherwise one is opened for the
+    /// duration of the operation.
+    /// </summary>
+    /// <param name="port"></param>
+    /// <param name="eeprom"></param>
+    /// <param name="offset"></param>
+    /// <param name="size"></param>
+    /// <param name="target"></param>
+    /// <param name="address">I2C bus address of the chip to read (0 to 7)</param>
+    public void Read(string port, EEPROM eeprom, UInt32 offset, UInt32 size, FileInfo target, int address = 0)
+    {
+      if ((address < 0) || (address > 7))
+        throw new ArgumentOutOfRangeException("address", "I2C bus address must be from 0 to 7.");
+      RunOperation(Operation.Reading, port, () =>
+      {
+        ConfigureChip(eeprom, (byte)(1 << address));
+        byte[] data = ReadBlock(offset, size, ProgressState.Read, "Reading data.");
+        // Now save the data to the file
+        FireProgress(ProgressState.Read, (int)size, (int)size + 1, String.Format("Saving to '{0}'", target.FullName));
+        File.WriteAllBytes(target.FullName, data);
+      });
+    }
+
+    /// <summary>
+    /// Write the contents of a file to an EEPROM. For I2C devices the same
+    /// data may be written to several chips on the bus in a single pass. If a
+    /// session is open on the port it is used (and left open), otherwise one
+    /// is opened for the duration of the operation.
+    /// </summary>
+    /// <param name="port"></param>
+    /// <param name="eeprom"></param>
+    /// <param name="offset"></param>
+    /// <param name="source"></param>
+    /// <param name="targets">I2C bus addresses to write (bit n = address n)</param>
+    public void Write(string port, EEPROM eeprom, UInt32 offset, FileInfo source, byte targets = 0x01)
+    {
+      RunOperation(Operation.Writing, port, () =>
+      {
+        // Read the data from the file
+        byte[] data = File.ReadAllBytes(source.FullName);
+        ConfigureChip(eeprom, targets);
+        if (offset < data.Length)
+          WriteBlock(data, (int)offset, data.Length - (int)offset, offset, "Writing data.");
+      });
+    }
+
+    /// <summary>
+    /// Run all the steps in a job using a single session.
+    /// </summary>
+    /// <param name="port"></param>
+    /// <param name="eeprom">The EEPROM type to use until the job selects one</param>
+    /// <param name="job"></param>
+    public void Run(string port, EEPROM eeprom, Job job)
+    {
+      RunOperation(Operation.Running, port, () =>
+      {
+        byte targets = 0x01;
+        foreach (JobStep step in job.Steps)
+        {
+          CheckCancel();
+          switch (step.Action)
+          {
+            case JobAction.Device:
+              eeprom = step.EEPROM;
+              targets = 0x01;
+              break;
+            case JobAction.Targets:
+              targets = step.Targets;
+              break;
+            case JobAction.Read:
+              {
+                ConfigureChip(eeprom, targets);
+                byte[] data = ReadBlock(step.Address, step.Size, ProgressState.Read, step.ToString());
+                File.WriteAllBytes(step.File.FullName, data);
+              }
+              break;
+            case JobAction.Write:
+              {
+                byte[] data = File.ReadAllBytes(step.File.FullName);
+                if (data.Length == 0)
+                  break;
+                ConfigureChip(eeprom, targets);
+                WriteBlock(data, 0, data.Length, step.Address, step.ToString());
+              }
+              break;
+            case JobAction.Verify:
+              {
+                byte[] data = File.ReadAllBytes(step.File.FullName);
+                ConfigureChip(eeprom, targets);
+                VerifyBlock(data, step.Address, step.ToString());
+              }
+              break;
+          }
+        }
+        FireProgress(ProgressState.Complete, 1, 1, String.Format("Job complete, {0} steps.", job.Steps.Count));
+      }, () => CheckJob(eeprom, job));
+    }
 
     /// <summary>
     /// Cancel the current operation.
@@ -0,0 +1,264 @@
+﻿using System;
+using System.IO;
+using System.Text;
+using System.Globalization;
+using System.Collections.Generic;
+
+namespace eeprog
+{
+  /// <summary>
+  /// The actions that may appear in a job file.
+  /// </summary>
+  public enum JobAction
+  {
+    Device,  // Select the EEPROM type
+    Targets, // Select the I2C bus addresses
+    Read,    // Read a region into a file
+    Write,   // Write a file into a region
+    Verify,  // Compare a region with a file
+  }
+
+  /// <summary>
+  /// Exceptions for errors in job files.
+  /// </summary>
+  public class JobException : Exception
+  {
+    public JobException(string message)
+      : base(message)
+    {
+      // Do nothing
+    }
+
+    public JobException(string message, Exception inner)
+      : base(message, inner)
+    {
+      // Do nothing
+    }
+  }
+
+  /// <summary>
+  /// A single step in a job.
+  /// </summary>
+  public class JobStep
+  {
+    public JobAction Action
+    {
+      get;
+      set;
+    }
+
+    /// <summary>
+    /// Line number in the job file (for messages).
+    /// </summary>
+    public int Line
+    {
+      get;
+      set;
+    }
+
+    /// <summary>
+    /// The EEPROM type (Device steps only).
+    /// </summary>
+    public EEPROM EEPROM
+    {
+      get;
+      set;
+    }
+
+    /// <summary>
+    /// I2C bus address mask (Targets steps only).
+    /// </summary>
+    public byte Targets
+    {
+      get;
+      set;
+    }
+
+    /// <summary>
+    /// Start address of the region in the EEPROM.
+    /// </summary>
+    public UInt32 Address
+    {
+      get;
+      set;
+    }
+
+    /// <summary>
+    /// Size of the region (Read steps only, the file size is used otherwise).
+    /// </summary>
+    public UInt32 Size
+    {
+      get;
+      set;
+    }
+
+    /// <summary>
+    /// The file to read from or write to.
+    /// </summary>
+    public FileInfo File
+    {
+      get;
+      set;
+    }
+
+    public override string ToString()
+    {
+      switch (Action)
+      {
+        case JobAction.Read:
+          return String.Format("Line {0}: read {1} bytes at {2:x6} into '{3}'", Line, Size, Address, File.Name);
+        case JobAction.Write:
+          return String.Format("Line {0}: write '{1}' at {2:x6}", Line, File.Name, Address);
+        case JobAction.Verify:
+          return String.Format("Line {0}: verify '{1}' at {2:x6}", Line, File.Name, Address);
+        case JobAction.Targets:
+          return String.Format("Line {0}: targets {1:x2}", Line, Targets);
+        default:
+          return String.Format("Line {0}: {1}", Line, Action);
+      }
+    }
+  }
+
+  /// <summary>
+  /// A list of read, write and verify steps to run in a single session.
+  ///
+  /// Job files are plain text with one step per line, blank lines and
+  /// anything following a '#' are ignored. Numbers may be decimal or hex
+  /// (with a '0x' prefix) and file names are relative to the job file.
+  ///
+  ///   eeprom  name                  - select the EEPROM type (and reset the
+  ///                                   targets to 0x01)
+  ///   targets mask                  - select the I2C bus addresses (I2C only)
+  ///   write   address file          - write a file at the address
+  ///   verify  address file          - compare the EEPROM with a file
+  ///   read    address size file     - read a region into a file
+  /// </summary>
+  public class Job
+  {
+    #region "Properties"
+    public List<JobStep> Steps
+    {
+      get;
+      private set;
+    }
+    #endregion
+
+    #region "Helper methods"
+    private static string NextToken(ref string rest)
+    {
+      rest = rest.TrimStart();
+      int end = 0;
+      while ((end < rest.Length) && !Char.IsWhiteSpace(rest[end]))
+        end++;
+      string token = rest.Substring(0, end);
+      rest = rest.Substring(end);
+      return token;
+    }
+
+    private static UInt32 ParseNumber(string value, int line)
+    {
+      UInt32 result;
+      bool valid;
+      if (value.StartsWith("0x", StringComparison.OrdinalIgnoreCase))
+        valid = UInt32.TryParse(value.Substring(2), NumberStyles.AllowHexSpecifier, CultureInfo.InvariantCulture, out result);
+      else
+        valid = UInt32.TryParse(value, NumberStyles.None, CultureInfo.InvariantCulture, out result);
+      if (!valid)
+        throw new JobException(String.Format("Line {0}: invalid number '{1}'.", line, value));
+      return result;
+    }
+
+    private static FileInfo ParseFile(string value, DirectoryInfo directory, int line)
+    {
+      value = value.Trim().Trim('"');
+      if (value.Length == 0)
+        throw new JobException(String.Format("Line {0}: file name required.", line));
+      return new FileInfo(Path.Combine(directory.FullName, value));
+    }
+    #endregion
+
+    #region "Public Methods"
+    public Job()
+    {
+      Steps = new List<JobStep>();
+    }
+
+    /// <summary>
+    /// Load a job from a file.
+    /// </summary>
+    /// <param name="source">The job file</param>
+    /// <param name="eeproms">Known EEPROM types by name</param>
+    /// <returns></returns>
+    public static Job Load(FileInfo source, IDictionary<string, EEPROM> eeproms)
+    {
+      using (StreamReader reader = source.OpenText())
+        return Parse(reader, source.Directory, eeproms);
+    }
+
+    /// <summary>
+    /// Parse a job from a reader.
+    /// </summary>
+    /// <param name="reader">Source of the job text</param>
+    /// <param name="directory">Directory relative file names are resolved against</param>
+    /// <param name="eeproms">Known EEPROM types by name</param>
+    /// <returns></returns>
+    public static Job Parse(TextReader reader, DirectoryInfo directory, IDictionary<string, EEPROM> eeproms)
+    {
+      Job job = new Job();
+      int line = 0;
+      for (string text = reader.ReadLine(); text != null; text = reader.ReadLine())
+      {
+        line++;
+        // Strip comments
+        int comment = text.IndexOf('#');
+        if (comment >= 0)
+          text = text.Substring(0, comment);
+        string rest = text;
+        string command = NextToken(ref rest).ToLowerInvariant();
+        if (command.Length == 0)
+          continue;
+        JobStep step = new JobStep();
+        step.Line = line;
+        switch (command)
+        {
+          case "eeprom":
+            {
+              string name = rest.Trim();
+              EEPROM eeprom;
+              if (!eeproms.TryGetValue(name, out eeprom))
+                throw new JobException(String.Format("Line {0}: unknown EEPROM '{1}'.", line, name));
+              step.Action = JobAction.Device;
+              step.EEPROM = eeprom;
+            }
+            break;
+          case "targets":
+            {
+              UInt32 mask = ParseNumber(NextToken(ref rest), line);
+              if ((mask == 0) || (mask > 0xff))
+                throw new JobException(String.Format("Line {0}: targets must be a mask from 0x01 to 0xff.", line));
+              step.Action = JobAction.Targets;
+              step.Targets = (byte)mask;
+            }
+            break;
+          case "write":
+          case "verify":
+            step.Action = (command == "write") ? JobAction.Write : JobAction.Verify;
+            step.Address = ParseNumber(NextToken(ref rest), line);
+            step.File = ParseFile(rest, directory, line);
+            break;
+          case "read":
+            step.Action = JobAction.Read;
+            step.Address = ParseNumber(NextToken(ref rest), line);
+            step.Size = ParseNumber(NextToken(ref rest), line);
+            step.File = ParseFile(rest, directory, line);
+            break;
+          default:
+            throw new JobException(String.Format("Line {0}: unknown command '{1}'.", line, command));
+        }
+        job.Steps.Add(step);
+      }
+      return job;
+    }
+    #endregion
+  }
+}
@@ -40,6 +40,7 @@
       this.groupBox2 = new System.Windows.Forms.GroupBox();
       this.m_progress = new System.Windows.Forms.ProgressBar();
       this.m_btnWrite = new System.Windows.Forms.Button();
+      this.m_btnJob = new System.Windows.Forms.Button();
       this.m_btnRead = new System.Windows.Forms.Button();
       this.m_lstEEPROM = new System.Windows.Forms.ComboBox();
       this.label2 = new System.Windows.Forms.Label();
@@ -50,11 +51,15 @@
       this.m_txtMessages = new System.Windows.Forms.TextBox();
       this.tabComms = new System.Windows.Forms.TabPage();
       this.m_txtComms = new System.Windows.Forms.TextBox();
+      this.tabStatistics = new System.Windows.Forms.TabPage();
+      this.m_txtStatistics = new System.Windows.Forms.TextBox();
+      this.m_btnSaveStatistics = new System.Windows.Forms.Button();
       this.groupBox1.SuspendLayout();
       this.groupBox2.SuspendLayout();
       this.tabControl1.SuspendLayout();
       this.tabMessages.SuspendLayout();
       this.tabComms.SuspendLayout();
+      this.tabStatistics.SuspendLayout();
       this.SuspendLayout();
       // 
       // groupBox1
@@ -155,6 +160,7 @@
       this.groupBox2.Anchor = ((System.Windows.Forms.AnchorStyles)((System.Windows.Forms.AnchorStyles.Top | System.Windows.Forms.AnchorStyles.Right)));
       this.groupBox2.Controls.Add(this.m_progress);
       this.groupBox2.Controls.Add(this.m_btnWrite);
+      this.groupBox2.Controls.Add(this.m_btnJob);
       this.groupBox2.Controls.Add(this.m_btnRead);
       this.groupBox2.Controls.Add(this.m_lstEEPROM);
       this.groupBox2.Controls.Add(this.label2);
@@ -184,6 +190,16 @@
       this.m_btnWrite.UseVisualStyleBackColor = true;
       this.m_btnWrite.Click += new System.EventHandler(this.OnWriteClick);
       // 
+      // m_btnJob
+      // 
+      this.m_btnJob.Location = new System.Drawing.Point(17, 72);
+      this.m_btnJob.Name = "m_btnJob";
+      this.m_btnJob.Size = new System.Drawing.Size(75, 23);
+      this.m_btnJob.TabIndex = 14;
+      this.m_btnJob.Text = "Run Job...";
+      this.m_btnJob.UseVisualStyleBackColor = true;
+      this.m_btnJob.Click += new System.EventHandler(this.OnJobClick);
+      // 
       // m_btnRead
       // 
       this.m_btnRead.Location = new System.Drawing.Point(97, 72);
@@ -235,6 +251,7 @@
       // 
       this.tabControl1.Controls.Add(this.tabMessages);
       this.tabControl1.Controls.Add(this.tabComms);
+      this.tabControl1.Controls.Add(this.tabStatistics);
       this.tabControl1.Dock = System.Windows.Forms.DockStyle.Bottom;
       this.tabControl1.Location = new System.Drawing.Point(0, 152);
       this.tabControl1.Name = "tabControl1";
@@ -286,6 +303,41 @@
       this.m_txtComms.Size = new System.Drawing.Size(495, 151);
       this.m_txtComms.TabIndex = 1;
       // 
+      // tabStatistics
+      // 
+      this.tabStatistics.Controls.Add(this.m_txtStatistics);
+      this.tabStatistics.Controls.Add(this.m_btnSaveStatistics);
+      this.tabStatistics.Location = new System.Drawing.Point(4, 22);
+      this.tabStatistics.Name = "tabStatistics";
+      this.tabStatistics.Padding = new System.Windows.Forms.Padding(3);
+      this.tabStatistics.Size = new System.Drawing.Size(501, 157);
+      this.tabStatistics.TabIndex = 2;
+      this.tabStatistics.Text = "Statistics";
+      this.tabStatistics.UseVisualStyleBackColor = true;
+      // 
+      // m_txtStatistics
+      // 
+      this.m_txtStatistics.Dock = System.Windows.Forms.DockStyle.Fill;
+      this.m_txtStatistics.Location = new System.Drawing.Point(3, 3);
+      this.m_txtStatistics.Multiline = true;
+      this.m_txtStatistics.Name = "m_txtStatistics";
+      this.m_txtStatistics.ReadOnly = true;
+      this.m_txtStatistics.ScrollBars = System.Windows.Forms.ScrollBars.Both;
+      this.m_txtStatistics.WordWrap = false;
+      this.m_txtStatistics.Size = new System.Drawing.Size(495, 128);
+      this.m_txtStatistics.TabIndex = 0;
+      // 
+      // m_btnSaveStatistics
+      // 
+      this.m_btnSaveStatistics.Dock = System.Windows.Forms.DockStyle.Bottom;
+      this.m_btnSaveStatistics.Location = new System.Drawing.Point(3, 131);
+      this.m_btnSaveStatistics.Name = "m_btnSaveStatistics";
+      this.m_btnSaveStatistics.Size = new System.Drawing.Size(495, 23);
+      this.m_btnSaveStatistics.TabIndex = 1;
+      this.m_btnSaveStatistics.Text = "Save Statistics...";
+      this.m_btnSaveStatistics.UseVisualStyleBackColor = true;
+      this.m_btnSaveStatistics.Click += new System.EventHandler(this.OnSaveStatisticsClick);
+      // 
       // MainForm
       // 
       this.AutoScaleDimensions = new System.Drawing.SizeF(6F, 13F);
@@ -307,6 +359,8 @@
       this.tabMessages.PerformLayout();
       this.tabComms.ResumeLayout(false);
       this.tabComms.PerformLayout();
+      this.tabStatistics.ResumeLayout(false);
+      this.tabStatistics.PerformLayout();
       this.ResumeLayout(false);
 
     }
@@ -325,6 +379,7 @@
     private System.Windows.Forms.GroupBox groupBox2;
     private System.Windows.Forms.ProgressBar m_progress;
     private System.Windows.Forms.Button m_btnWrite;
+    private System.Windows.Forms.Button m_btnJob;
     private System.Windows.Forms.Button m_btnRead;
     private System.Windows.Forms.ComboBox m_lstEEPROM;
     private System.Windows.Forms.Label label2;
@@ -335,6 +390,9 @@
     private System.Windows.Forms.TextBox m_txtMessages;
     private System.Windows.Forms.TabPage tabComms;
     private System.Windows.Forms.TextBox m_txtComms;
+    private System.Windows.Forms.TabPage tabStatistics;
+    private System.Windows.Forms.TextBox m_txtStatistics;
+    private System.Windows.Forms.Button m_btnSaveStatistics;
   }
 }
 
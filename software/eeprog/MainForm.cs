@@ -35,6 +35,10 @@ namespace eeprog
         "25AA1024",
         new EEPROM(ConnectionType.SPI, 8, 17, 3)
         );
+      m_eeproms.Add(
+        "24C65",
+        new EEPROM(ConnectionType.I2C, 6, 13, 2)
+        );
       // Populate lists
       m_lstChipType.Items.Add(ConnectionType.I2C.ToString());
       m_lstChipType.Items.Add(ConnectionType.SPI.ToString());
@@ -125,6 +129,63 @@ namespace eeprog
       }
     }
 
+    private void OnJobClick(object sender, EventArgs e)
+    {
+      // Get the port and the default EEPROM to use
+      string port = m_lstPort.SelectedItem.ToString();
+      EEPROM eeprom;
+      if (!m_eeproms.TryGetValue(m_lstEEPROM.SelectedItem.ToString(), out eeprom))
+      {
+        MessageBox.Show("No EEPROM selected.", "Error!", MessageBoxButtons.OK, MessageBoxIcon.Error);
+        return;
+      }
+      // Determine what job to run
+      OpenFileDialog dlg = new OpenFileDialog();
+      dlg.DefaultExt = "job";
+      dlg.AddExtension = true;
+      dlg.CheckFileExists = true;
+      dlg.Title = "Open Job File";
+      dlg.Filter = "Job File (*.job)|*.job";
+      if (dlg.ShowDialog() != DialogResult.OK)
+        return;
+      Job job;
+      try
+      {
+        job = Job.Load(new FileInfo(dlg.FileName), m_eeproms);
+      }
+      catch (Exception ex)
+      {
+        MessageBox.Show(ex.Message, "Error!", MessageBoxButtons.OK, MessageBoxIcon.Error);
+        return;
+      }
+      // Run all the steps in a single session
+      Task.Factory.StartNew(() =>
+      {
+        m_loader.Run(port, eeprom, job);
+      });
+    }
+
+    private void OnSaveStatisticsClick(object sender, EventArgs e)
+    {
+      // Determine where to save the statistics
+      SaveFileDialog dlg = new SaveFileDialog();
+      dlg.DefaultExt = "csv";
+      dlg.AddExtension = true;
+      dlg.OverwritePrompt = true;
+      dlg.Title = "Save Statistics";
+      dlg.Filter = "CSV File (*.csv)|*.csv|JSON File (*.json)|*.json";
+      if (dlg.ShowDialog() != DialogResult.OK)
+        return;
+      try
+      {
+        m_loader.Telemetry.Save(new FileInfo(dlg.FileName));
+      }
+      catch (Exception ex)
+      {
+        MessageBox.Show(ex.Message, "Error!", MessageBoxButtons.OK, MessageBoxIcon.Error);
+      }
+    }
+
     #endregion
 
     private void LogMessage(TextBox target, string message)
@@ -138,16 +199,20 @@ namespace eeprog
       {
         m_btnRead.Enabled = true;
         m_btnWrite.Enabled = true;
+        m_btnJob.Enabled = true;
         m_lstEEPROM.Enabled = true;
         m_lstPort.Enabled = true;
+        m_btnSaveStatistics.Enabled = true;
         m_progress.Value = 0;
       }
       else
       {
         m_btnRead.Enabled = false;
         m_btnWrite.Enabled = false;
+        m_btnJob.Enabled = false;
         m_lstEEPROM.Enabled = false;
         m_lstPort.Enabled = false;
+        m_btnSaveStatistics.Enabled = false;
       }
     }
 
@@ -202,6 +267,8 @@ namespace eeprog
       // Safe to use UI
       UpdateUI();
       LogMessage(m_txtMessages, String.Format("Programmer {0}", state));
+      if (state == ConnectionState.Disconnected)
+        m_txtStatistics.Text = m_loader.Telemetry.Summary;
     }
 
     #endregion
@@ -0,0 +1,588 @@
+﻿using System;
+using System.IO;
+using System.Text;
+using System.Diagnostics;
+using System.Globalization;
+using System.Collections.Generic;
+
+namespace eeprog
+{
+  /// <summary>
+  /// Timing information for a single command/response exchange.
+  /// </summary>
+  public class CommandTiming
+  {
+    /// <summary>
+    /// The command code (first character of the command line).
+    /// </summary>
+    public char Command
+    {
+      get;
+      set;
+    }
+
+    /// <summary>
+    /// Time taken to write the command to the serial port.
+    /// </summary>
+    public TimeSpan Send
+    {
+      get;
+      set;
+    }
+
+    /// <summary>
+    /// Time from the start of the send until the first response byte.
+    /// </summary>
+    public TimeSpan FirstByte
+    {
+      get;
+      set;
+    }
+
+    /// <summary>
+    /// Time from the start of the send until the full response line.
+    /// </summary>
+    public TimeSpan Line
+    {
+      get;
+      set;
+    }
+
+    /// <summary>
+    /// Number of bytes sent (including the line terminator).
+    /// </summary>
+    public int BytesSent
+    {
+      get;
+      set;
+    }
+
+    /// <summary>
+    /// Number of bytes received (including the line terminator).
+    /// </summary>
+    public int BytesReceived
+    {
+      get;
+      set;
+    }
+  }
+
+  /// <summary>
+  /// Latency histogram with fixed (millisecond) buckets.
+  /// </summary>
+  public class LatencyHistogram
+  {
+    /// <summary>
+    /// Upper bound (in ms) of each bucket. Samples above the last bound are
+    /// counted in an additional overflow bucket.
+    /// </summary>
+    public static readonly double[] BUCKETS = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2500 };
+
+    #region "Instance Variables"
+    private int[]  m_counts; // Sample count per bucket
+    private double m_total;  // Sum of all samples (ms)
+    private double m_min;    // Smallest sample (ms)
+    private double m_max;    // Largest sample (ms)
+    #endregion
+
+    #region "Properties"
+    /// <summary>
+    /// Number of samples recorded.
+    /// </summary>
+    public int Count
+    {
+      get;
+      private set;
+    }
+
+    /// <summary>
+    /// Sample count for each bucket (BUCKETS.Length + 1 entries).
+    /// </summary>
+    public int[] Counts
+    {
+      get
+      {
+        return (int[])m_counts.Clone();
+      }
+    }
+
+    public double Min
+    {
+      get
+      {
+        return (Count == 0) ? 0 : m_min;
+      }
+    }
+
+    public double Max
+    {
+      get
+      {
+        return m_max;
+      }
+    }
+
+    public double Mean
+    {
+      get
+      {
+        return (Count == 0) ? 0 : m_total / Count;
+      }
+    }
+    #endregion
+
+    #region "Public Methods"
+    public LatencyHistogram()
+    {
+      m_counts = new int[BUCKETS.Length + 1];
+    }
+
+    public LatencyHistogram(LatencyHistogram other)
+    {
+      m_counts = (int[])other.m_counts.Clone();
+      m_total = other.m_total;
+      m_min = other.m_min;
+      m_max = other.m_max;
+      Count = other.Count;
+    }
+
+    /// <summary>
+    /// Add a sample to the histogram.
+    /// </summary>
+    /// <param name="sample"></param>
+    public void Add(TimeSpan sample)
+    {
+      double ms = sample.TotalMilliseconds;
+      int bucket = 0;
+      while ((bucket < BUCKETS.Length) && (ms > BUCKETS[bucket]))
+        bucket++;
+      m_counts[bucket]++;
+      m_total += ms;
+      if ((Count == 0) || (ms < m_min))
+        m_min = ms;
+      if (ms > m_max)
+        m_max = ms;
+      Count++;
+    }
+
+    /// <summary>
+    /// Estimate a percentile from the bucket counts. The result is the upper
+    /// bound of the bucket containing the percentile (or the maximum sample
+    /// for the overflow bucket).
+    /// </summary>
+    /// <param name="percentile">Percentile to estimate (0 - 100)</param>
+    /// <returns></returns>
+    public double Percentile(double percentile)
+    {
+      if (Count == 0)
+        return 0;
+      int target = (int)Math.Ceiling(Count * percentile / 100.0);
+      int seen = 0;
+      for (int i = 0; i < BUCKETS.Length; i++)
+      {
+        seen += m_counts[i];
+        if (seen >= target)
+          return Math.Min(BUCKETS[i], m_max);
+      }
+      return m_max;
+    }
+    #endregion
+  }
+
+  /// <summary>
+  /// Accumulated statistics for a single command code.
+  /// </summary>
+  public class CommandStatistics
+  {
+    #region "Properties"
+    public char Command
+    {
+      get;
+      private set;
+    }
+
+    /// <summary>
+    /// Number of completed exchanges.
+    /// </summary>
+    public int Count
+    {
+      get;
+      private set;
+    }
+
+    /// <summary>
+    /// Number of exchanges that received a failure response.
+    /// </summary>
+    public int Failures
+    {
+      get;
+      private set;
+    }
+
+    /// <summary>
+    /// Number of exchanges that timed out waiting for a response.
+    /// </summary>
+    public int Timeouts
+    {
+      get;
+      private set;
+    }
+
+    /// <summary>
+    /// Number of exchanges that were repeated after an error.
+    /// </summary>
+    public int Retries
+    {
+      get;
+      private set;
+    }
+
+    public long BytesSent
+    {
+      get;
+      private set;
+    }
+
+    public long BytesReceived
+    {
+      get;
+      private set;
+    }
+
+    public LatencyHistogram Send
+    {
+      get;
+      private set;
+    }
+
+    public LatencyHistogram FirstByte
+    {
+      get;
+      private set;
+    }
+
+    public LatencyHistogram Line
+    {
+      get;
+      private set;
+    }
+    #endregion
+
+    #region "Public Methods"
+    public CommandStatistics(char command)
+    {
+      Command = command;
+      Send = new LatencyHistogram();
+      FirstByte = new LatencyHistogram();
+      Line = new LatencyHistogram();
+    }
+
+    public CommandStatistics(CommandStatistics other)
+    {
+      Command = other.Command;
+      Count = other.Count;
+      Failures = other.Failures;
+      Timeouts = other.Timeouts;
+      Retries = other.Retries;
+      BytesSent = other.BytesSent;
+      BytesReceived = other.BytesReceived;
+      Send = new LatencyHistogram(other.Send);
+      FirstByte = new LatencyHistogram(other.FirstByte);
+      Line = new LatencyHistogram(other.Line);
+    }
+
+    public void Add(CommandTiming timing)
+    {
+      Count++;
+      BytesSent += timing.BytesSent;
+      BytesReceived += timing.BytesReceived;
+      Send.Add(timing.Send);
+      FirstByte.Add(timing.FirstByte);
+      Line.Add(timing.Line);
+    }
+
+    public void AddFailure()
+    {
+      Failures++;
+    }
+
+    public void AddTimeout()
+    {
+      Timeouts++;
+    }
+
+    public void AddRetry()
+    {
+      Retries++;
+    }
+    #endregion
+  }
+
+  /// <summary>
+  /// Collects per-command timing and throughput statistics for a job. All
+  /// methods are thread safe so the statistics may be queried while a job is
+  /// running in the background.
+  /// </summary>
+  public class Telemetry
+  {
+    #region "Instance Variables"
+    private object                               m_lock;     // Protects all state
+    private Stopwatch                            m_elapsed;  // Wall time for the job
+    private Dictionary<char, CommandStatistics> m_commands; // Statistics by command code
+    #endregion
+
+    #region "Properties"
+    /// <summary>
+    /// Time the current (or last) job was started.
+    /// </summary>
+    public DateTime Started
+    {
+      get;
+      private set;
+    }
+
+    /// <summary>
+    /// Elapsed time for the current (or last) job.
+    /// </summary>
+    public TimeSpan Elapsed
+    {
+      get
+      {
+        lock (m_lock)
+          return m_elapsed.Elapsed;
+      }
+    }
+
+    /// <summary>
+    /// Total bytes transferred (both directions) per second of job time.
+    /// </summary>
+    public double BytesPerSecond
+    {
+      get
+      {
+        lock (m_lock)
+        {
+          double seconds = m_elapsed.Elapsed.TotalSeconds;
+          if (seconds <= 0)
+            return 0;
+          long bytes = 0;
+          foreach (CommandStatistics stats in m_commands.Values)
+            bytes += stats.BytesSent + stats.BytesReceived;
+          return bytes / seconds;
+        }
+      }
+    }
+
+    /// <summary>
+    /// A short, human readable summary of the statistics.
+    /// </summary>
+    public string Summary
+    {
+      get
+      {
+        List<CommandStatistics> commands = Snapshot();
+        int count = 0, failures = 0, timeouts = 0, retries = 0;
+        foreach (CommandStatistics stats in commands)
+        {
+          count += stats.Count;
+          failures += stats.Failures;
+          timeouts += stats.Timeouts;
+          retries += stats.Retries;
+        }
+        StringBuilder builder = new StringBuilder();
+        builder.AppendFormat(CultureInfo.InvariantCulture,
+          "{0} commands in {1:0.00}s, {2:0} bytes/s, {3} failures, {4} timeouts, {5} retries",
+          count, Elapsed.TotalSeconds, BytesPerSecond, failures, timeouts, retries);
+        foreach (CommandStatistics stats in commands)
+          builder.AppendFormat(CultureInfo.InvariantCulture,
+            "\r\n  '{0}' x{1}: first byte {2:0.0}/{3:0.0}/{4:0.0}ms, line {5:0.0}/{6:0.0}/{7:0.0}ms (mean/p95/max)",
+            stats.Command, stats.Count,
+            stats.FirstByte.Mean, stats.FirstByte.Percentile(95), stats.FirstByte.Max,
+            stats.Line.Mean, stats.Line.Percentile(95), stats.Line.Max);
+        return builder.ToString();
+      }
+    }
+    #endregion
+
+    #region "Helper methods"
+    private CommandStatistics GetStatistics(char command)
+    {
+      CommandStatistics stats;
+      if (!m_commands.TryGetValue(command, out stats))
+      {
+        stats = new CommandStatistics(command);
+        m_commands.Add(command, stats);
+      }
+      return stats;
+    }
+
+    private static string Format(double value)
+    {
+      return value.ToString("0.###", CultureInfo.InvariantCulture);
+    }
+    #endregion
+
+    #region "Public Methods"
+    public Telemetry()
+    {
+      m_lock = new object();
+      m_elapsed = new Stopwatch();
+      m_commands = new Dictionary<char, CommandStatistics>();
+      Started = DateTime.Now;
+    }
+
+    /// <summary>
+    /// Clear all statistics and start timing a new job.
+    /// </summary>
+    public void Start()
+    {
+      lock (m_lock)
+      {
+        m_commands.Clear();
+        m_elapsed.Restart();
+        Started = DateTime.Now;
+      }
+    }
+
+    /// <summary>
+    /// Stop timing the current job. The statistics remain available until the
+    /// next call to Start().
+    /// </summary>
+    public void Stop()
+    {
+      lock (m_lock)
+        m_elapsed.Stop();
+    }
+
+    public void Record(CommandTiming timing)
+    {
+      lock (m_lock)
+        GetStatistics(timing.Command).Add(timing);
+    }
+
+    public void RecordFailure(char command)
+    {
+      lock (m_lock)
+        GetStatistics(command).AddFailure();
+    }
+
+    public void RecordTimeout(char command)
+    {
+      lock (m_lock)
+        GetStatistics(command).AddTimeout();
+    }
+
+    public void RecordRetry(char command)
+    {
+      lock (m_lock)
+        GetStatistics(command).AddRetry();
+    }
+
+    /// <summary>
+    /// Get a copy of the statistics for each command, ordered by command code.
+    /// </summary>
+    /// <returns></returns>
+    public List<CommandStatistics> Snapshot()
+    {
+      List<CommandStatistics> result = new List<CommandStatistics>();
+      lock (m_lock)
+      {
+        foreach (CommandStatistics stats in m_commands.Values)
+          result.Add(new CommandStatistics(stats));
+      }
+      result.Sort((a, b) => a.Command.CompareTo(b.Command));
+      return result;
+    }
+
+    /// <summary>
+    /// Export the statistics as CSV, one row per command code. The job level
+    /// values (start time, elapsed time and throughput) are repeated on each
+    /// row.
+    /// </summary>
+    /// <returns></returns>
+    public string ToCsv()
+    {
+      StringBuilder builder = new StringBuilder();
+      string job = String.Format("{0},{1},{2}",
+        Started.ToString("o", CultureInfo.InvariantCulture), Format(Elapsed.TotalMilliseconds), Format(BytesPerSecond));
+      builder.Append("started,elapsed_ms,bytes_per_second,command,count,failures,timeouts,retries,bytes_sent,bytes_received");
+      foreach (string name in new string[] { "send", "first_byte", "line" })
+        builder.AppendFormat(",{0}_min_ms,{0}_mean_ms,{0}_p95_ms,{0}_max_ms", name);
+      foreach (double bound in LatencyHistogram.BUCKETS)
+        builder.AppendFormat(",line_le_{0}ms", Format(bound));
+      builder.Append(",line_gt_" + Format(LatencyHistogram.BUCKETS[LatencyHistogram.BUCKETS.Length - 1]) + "ms");
+      builder.Append("\r\n");
+      foreach (CommandStatistics stats in Snapshot())
+      {
+        builder.AppendFormat("{0},{1},{2},{3},{4},{5},{6},{7}",
+          job, stats.Command, stats.Count, stats.Failures, stats.Timeouts, stats.Retries, stats.BytesSent, stats.BytesReceived);
+        foreach (LatencyHistogram histogram in new LatencyHistogram[] { stats.Send, stats.FirstByte, stats.Line })
+          builder.AppendFormat(",{0},{1},{2},{3}",
+            Format(histogram.Min), Format(histogram.Mean), Format(histogram.Percentile(95)), Format(histogram.Max));
+        foreach (int count in stats.Line.Counts)
+          builder.AppendFormat(",{0}", count);
+        builder.Append("\r\n");
+      }
+      return builder.ToString();
+    }
+
+    /// <summary>
+    /// Export the statistics as a JSON document.
+    /// </summary>
+    /// <returns></returns>
+    public string ToJson()
+    {
+      StringBuilder builder = new StringBuilder();
+      builder.Append("{\n");
+      builder.AppendFormat("  \"started\": \"{0}\",\n", Started.ToString("o", CultureInfo.InvariantCulture));
+      builder.AppendFormat("  \"elapsed_ms\": {0},\n", Format(Elapsed.TotalMilliseconds));
+      builder.AppendFormat("  \"bytes_per_second\": {0},\n", Format(BytesPerSecond));
+      builder.Append("  \"buckets_ms\": [");
+      for (int i = 0; i < LatencyHistogram.BUCKETS.Length; i++)
+        builder.Append((i > 0 ? ", " : "") + Format(LatencyHistogram.BUCKETS[i]));
+      builder.Append("],\n");
+      builder.Append("  \"commands\": [");
+      bool first = true;
+      foreach (CommandStatistics stats in Snapshot())
+      {
+        builder.Append(first ? "\n" : ",\n");
+        first = false;
+        builder.Append("    {\n");
+        builder.AppendFormat("      \"command\": \"{0}\",\n", (stats.Command == '"' || stats.Command == '\\') ? "\\" + stats.Command : stats.Command.ToString());
+        builder.AppendFormat("      \"count\": {0},\n", stats.Count);
+        builder.AppendFormat("      \"failures\": {0},\n", stats.Failures);
+        builder.AppendFormat("      \"timeouts\": {0},\n", stats.Timeouts);
+        builder.AppendFormat("      \"retries\": {0},\n", stats.Retries);
+        builder.AppendFormat("      \"bytes_sent\": {0},\n", stats.BytesSent);
+        builder.AppendFormat("      \"bytes_received\": {0}", stats.BytesReceived);
+        string[] names = { "send", "first_byte", "line" };
+        LatencyHistogram[] histograms = { stats.Send, stats.FirstByte, stats.Line };
+        for (int i = 0; i < names.Length; i++)
+        {
+          LatencyHistogram histogram = histograms[i];
+          builder.AppendFormat(",\n      \"{0}\": {{ \"min_ms\": {1}, \"mean_ms\": {2}, \"p95_ms\": {3}, \"max_ms\": {4}, \"counts\": [{5}] }}",
+            names[i], Format(histogram.Min), Format(histogram.Mean), Format(histogram.Percentile(95)), Format(histogram.Max),
+            String.Join(", ", histogram.Counts));
+        }
+        builder.Append("\n    }");
+      }
+      builder.Append(first ? "]\n" : "\n  ]\n");
+      builder.Append("}\n");
+      return builder.ToString();
+    }
+
+    /// <summary>
+    /// Save the statistics to a file. The format is selected by the file
+    /// extension - '.json' for JSON, anything else for CSV.
+    /// </summary>
+    /// <param name="target"></param>
+    public void Save(FileInfo target)
+    {
+      if (String.Compare(target.Extension, ".json", StringComparison.OrdinalIgnoreCase) == 0)
+        File.WriteAllText(target.FullName, ToJson());
+      else
+        File.WriteAllText(target.FullName, ToCsv());
+    }
+    #endregion
+  }
+}